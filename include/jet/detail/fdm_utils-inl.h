@@ -0,0 +1,60 @@
+// Copyright (c) 2018 Doyub Kim
+//
+// I am making my contributions/submissions to this project solely in my
+// personal capacity and am not conveying any rights to any intellectual
+// property of any third parties.
+
+#ifndef INCLUDE_JET_DETAIL_FDM_UTILS_INL_H_
+#define INCLUDE_JET_DETAIL_FDM_UTILS_INL_H_
+
+#include <jet/macros.h>
+
+namespace jet {
+
+template <typename T, typename Markers>
+JET_FORCE_INLINE T laplacianFluidMasked(
+    const ConstArrayAccessor3<T>& data,
+    const Markers& marker,
+    char fluidMarker,
+    const Vector3D& invGridSpacingSq,
+    size_t i,
+    size_t j,
+    size_t k) {
+    const T center = data(i, j, k);
+    const Size3 ds = data.size();
+
+    JET_ASSERT(i < ds.x && j < ds.y && k < ds.z);
+
+    // Neighbor indices are clamped to the domain so that an edge neighbor
+    // reloads the center cell and its difference vanishes, and the marker
+    // tests fold into 0/1 weights. This removes all twelve branches from
+    // the stencil; the ternaries compile to selects.
+    const size_t im = i - (i > 0 ? 1 : 0);
+    const size_t ip = i + (i + 1 < ds.x ? 1 : 0);
+    const size_t jm = j - (j > 0 ? 1 : 0);
+    const size_t jp = j + (j + 1 < ds.y ? 1 : 0);
+    const size_t km = k - (k > 0 ? 1 : 0);
+    const size_t kp = k + (k + 1 < ds.z ? 1 : 0);
+
+    const double wl = (marker(im, j, k) == fluidMarker) ? 1.0 : 0.0;
+    const double wr = (marker(ip, j, k) == fluidMarker) ? 1.0 : 0.0;
+    const double wd = (marker(i, jm, k) == fluidMarker) ? 1.0 : 0.0;
+    const double wu = (marker(i, jp, k) == fluidMarker) ? 1.0 : 0.0;
+    const double wb = (marker(i, j, km) == fluidMarker) ? 1.0 : 0.0;
+    const double wf = (marker(i, j, kp) == fluidMarker) ? 1.0 : 0.0;
+
+    const T dleft = wl * (center - data(im, j, k));
+    const T dright = wr * (data(ip, j, k) - center);
+    const T ddown = wd * (center - data(i, jm, k));
+    const T dup = wu * (data(i, jp, k) - center);
+    const T dback = wb * (center - data(i, j, km));
+    const T dfront = wf * (data(i, j, kp) - center);
+
+    return (dright - dleft) * invGridSpacingSq.x
+        + (dup - ddown) * invGridSpacingSq.y
+        + (dfront - dback) * invGridSpacingSq.z;
+}
+
+}  // namespace jet
+
+#endif  // INCLUDE_JET_DETAIL_FDM_UTILS_INL_H_
@@ -356,6 +356,37 @@ void parallelRangeFor(IndexType beginIndexX, IndexType endIndexX,
                      policy);
 }
 
+template <typename IndexType, typename Function>
+void parallelForTiled3D(IndexType beginIndexY, IndexType endIndexY,
+                        IndexType beginIndexZ, IndexType endIndexZ,
+                        IndexType tileSizeY, IndexType tileSizeZ,
+                        const Function& function, ExecutionPolicy policy) {
+    if (beginIndexY >= endIndexY || beginIndexZ >= endIndexZ) {
+        return;
+    }
+
+    JET_ASSERT(tileSizeY > 0 && tileSizeZ > 0);
+
+    const IndexType sizeY = endIndexY - beginIndexY;
+    const IndexType sizeZ = endIndexZ - beginIndexZ;
+    const IndexType numTilesY = (sizeY + tileSizeY - 1) / tileSizeY;
+    const IndexType numTilesZ = (sizeZ + tileSizeZ - 1) / tileSizeZ;
+
+    parallelFor(IndexType(0), numTilesY * numTilesZ,
+                [&](IndexType tileIdx) {
+                    const IndexType tileY = tileIdx % numTilesY;
+                    const IndexType tileZ = tileIdx / numTilesY;
+                    const IndexType yBegin = beginIndexY + tileY * tileSizeY;
+                    const IndexType zBegin = beginIndexZ + tileZ * tileSizeZ;
+                    const IndexType yEnd =
+                        std::min(yBegin + tileSizeY, endIndexY);
+                    const IndexType zEnd =
+                        std::min(zBegin + tileSizeZ, endIndexZ);
+                    function(yBegin, yEnd, zBegin, zEnd);
+                },
+                policy);
+}
+
 template <typename IndexType, typename Value, typename Function,
           typename Reduce>
 Value parallelReduce(IndexType start, IndexType end, const Value& identity,
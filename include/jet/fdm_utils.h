@@ -84,6 +84,24 @@ Vector3D laplacian3(
     size_t j,
     size_t k);
 
+//! \brief Returns 3-D Laplacian value from given 3-D grid-like array \p data,
+//!        reciprocal squared grid spacing \p invGridSpacingSq, and array index
+//!        (\p i, \p j, \p k), where only neighbors whose marker equals
+//!        \p fluidMarker contribute. Neighbor indices are clamped to the
+//!        domain and the marker tests are folded into 0/1 weights, so the
+//!        stencil is branch-free.
+template <typename T, typename Markers>
+T laplacianFluidMasked(
+    const ConstArrayAccessor3<T>& data,
+    const Markers& marker,
+    char fluidMarker,
+    const Vector3D& invGridSpacingSq,
+    size_t i,
+    size_t j,
+    size_t k);
+
 }  // namespace jet
 
+#include "detail/fdm_utils-inl.h"
+
 #endif  // INCLUDE_JET_FDM_UTILS_H_
@@ -26,6 +26,12 @@
 #   define JET_ASSERT(x)
 #endif
 
+#if defined(_MSC_VER)
+#   define JET_FORCE_INLINE __forceinline
+#else
+#   define JET_FORCE_INLINE inline __attribute__((always_inline))
+#endif
+
 #ifdef __cplusplus
 #define JET_NON_COPYABLE(ClassName) \
     ClassName(const ClassName&) = delete; \
@@ -178,6 +178,39 @@ void parallelRangeFor(IndexType beginIndexX, IndexType endIndexX,
                       const Function& function,
                       ExecutionPolicy policy = ExecutionPolicy::kParallel);
 
+//!
+//! \brief      Makes a cache-blocked loop over the (Y, Z) plane of a 3D
+//!             traversal in parallel.
+//!
+//! This function partitions the index plane [beginIndexY, endIndexY) x
+//! [beginIndexZ, endIndexZ) into tiles of at most \p tileSizeY by
+//! \p tileSizeZ indices and schedules one call of \p function per tile with
+//! the tile's index ranges. The X dimension is intentionally left to the
+//! caller so rows can be streamed contiguously inside a tile, keeping the
+//! working set of a stencil (e.g. three k-planes of a tile) cache resident.
+//! The order of the tile visits is not guaranteed due to the nature of
+//! parallel execution.
+//!
+//! \param[in]  beginIndexY The begin index in Y dimension.
+//! \param[in]  endIndexY   The end index in Y dimension.
+//! \param[in]  beginIndexZ The begin index in Z dimension.
+//! \param[in]  endIndexZ   The end index in Z dimension.
+//! \param[in]  tileSizeY   The maximum tile extent in Y dimension.
+//! \param[in]  tileSizeZ   The maximum tile extent in Z dimension.
+//! \param[in]  function    The function to call per tile with arguments
+//!                         (beginY, endY, beginZ, endZ).
+//! \param[in]  policy      The execution policy (parallel or serial).
+//!
+//! \tparam     IndexType   Index type.
+//! \tparam     Function    Function type.
+//!
+template <typename IndexType, typename Function>
+void parallelForTiled3D(IndexType beginIndexY, IndexType endIndexY,
+                        IndexType beginIndexZ, IndexType endIndexZ,
+                        IndexType tileSizeY, IndexType tileSizeZ,
+                        const Function& function,
+                        ExecutionPolicy policy = ExecutionPolicy::kParallel);
+
 //!
 //! \brief      Performs reduce operation in parallel.
 //!
@@ -5,9 +5,16 @@
 // property of any third parties.
 
 #include <pch.h>
+#include <jet/array_samplers3.h>
+#include <jet/constants.h>
 #include <jet/fdm_utils.h>
 #include <jet/grid_forward_euler_diffusion_solver3.h>
 #include <jet/level_set_utils.h>
+#include <jet/parallel.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
 
 using namespace jet;
 
@@ -15,55 +22,326 @@ static const char kFluid = 0;
 static const char kAir = 1;
 static const char kBoundary = 2;
 
-template <typename T>
-T laplacian(
-    const ConstArrayAccessor3<T>& data,
-    const Array3<char>& marker,
-    const Vector3D& gridSpacing,
-    size_t i,
-    size_t j,
-    size_t k) {
-    const T center = data(i, j, k);
-    const Size3 ds = data.size();
-
-    JET_ASSERT(i < ds.x && j < ds.y && k < ds.z);
-
-    T dleft = zero<T>();
-    T dright = zero<T>();
-    T ddown = zero<T>();
-    T dup = zero<T>();
-    T dback = zero<T>();
-    T dfront = zero<T>();
-
-    if (i > 0 && marker(i - 1, j, k) == kFluid) {
-        dleft = center - data(i - 1, j, k);
+// Tile extents for the (j, k) plane of the stencil loops. Three k-planes of
+// a 32x8 tile of doubles stay within about 6 KiB, so the neighborhood of a
+// tile remains L1-resident while rows stream along i.
+static const size_t kTileSizeJ = 32;
+static const size_t kTileSizeK = 8;
+
+// Row chunk length for stack-resident per-row masks; 256 cells pack into
+// four 64-bit words.
+static const size_t kRowChunkSize = 256;
+
+//
+// Tile-local marker scratchpad, packed 2 bits per cell and 32 cells per
+// 64-bit word along the i-axis. One instance covers the rows of a single
+// (j, k) tile plus a one-row halo, which is all the markers the stencil of
+// that tile can touch. Declared thread_local at the point of use, so the
+// buffer is allocated once per worker thread and then recycled from tile to
+// tile instead of materializing a full-grid marker volume.
+//
+struct TileMarkers {
+    Size3 ds;
+    size_t wordsPerRow = 0;
+    size_t jLo = 0;
+    size_t kLo = 0;
+    size_t numRowsJ = 0;
+    std::vector<uint64_t> words;
+
+    //! Rebinds the scratchpad to tile [\p jBegin, \p jEnd) x [\p kBegin,
+    //! \p kEnd) of a grid with data size \p dataSize, halo included.
+    void reset(
+        const Size3& dataSize,
+        size_t jBegin, size_t jEnd,
+        size_t kBegin, size_t kEnd) {
+        ds = dataSize;
+        wordsPerRow = (ds.x + 31) / 32;
+        jLo = jBegin - (jBegin > 0 ? 1 : 0);
+        kLo = kBegin - (kBegin > 0 ? 1 : 0);
+        const size_t jHi = std::min(jEnd + 1, ds.y);
+        const size_t kHi = std::min(kEnd + 1, ds.z);
+        numRowsJ = jHi - jLo;
+        words.resize(wordsPerRow * numRowsJ * (kHi - kLo));
     }
-    if (i + 1 < ds.x && marker(i + 1, j, k) == kFluid) {
-        dright = data(i + 1, j, k) - center;
+
+    //! Returns the packed words for row (j, k); the row must lie within the
+    //! bound tile or its halo.
+    const uint64_t* row(size_t j, size_t k) const {
+        return words.data() + wordsPerRow * ((j - jLo) + numRowsJ * (k - kLo));
+    }
+
+    uint64_t* row(size_t j, size_t k) {
+        return words.data() + wordsPerRow * ((j - jLo) + numRowsJ * (k - kLo));
     }
 
-    if (j > 0 && marker(i, j - 1, k) == kFluid) {
-        ddown = center - data(i, j - 1, k);
+    char operator()(size_t i, size_t j, size_t k) const {
+        return static_cast<char>((row(j, k)[i >> 5] >> ((i & 31) * 2))
+            & UINT64_C(3));
     }
-    if (j + 1 < ds.y && marker(i, j + 1, k) == kFluid) {
-        dup = data(i, j + 1, k) - center;
+};
+
+// Samples an SDF once at every point of a regular lattice given by origin
+// and spacing. This is the only place the virtual sampler is invoked; it
+// runs as a single streaming pass, and every later classification is a
+// plain array load. A virtual trilinear sample costs an indirect call plus
+// eight gathered loads per query, so materializing the lattice is cheaper
+// than sampling even twice.
+static void presampleSdf(
+    const ScalarField3& sdf,
+    const Vector3D& origin,
+    const Vector3D& gridSpacing,
+    const Size3& size,
+    Array3<double>* sampled);
+
+// Samples an SDF onto a regular lattice through a concrete sampler type, so
+// the per-point sample call inlines into the lattice loop instead of going
+// through virtual dispatch.
+template <typename Sampler>
+static void presampleSdfImpl(
+    const Sampler& sampler,
+    const Vector3D& origin,
+    const Vector3D& gridSpacing,
+    const Size3& size,
+    ArrayAccessor3<double> acc) {
+    parallelFor(
+        kZeroSize, size.x, kZeroSize, size.y, kZeroSize, size.z,
+        [&](size_t i, size_t j, size_t k) {
+            acc(i, j, k) = sampler(Vector3D(
+                origin.x + gridSpacing.x * i,
+                origin.y + gridSpacing.y * j,
+                origin.z + gridSpacing.z * k));
+        });
+}
+
+static void presampleSdf(
+    const ScalarField3& sdf,
+    const Vector3D& origin,
+    const Vector3D& gridSpacing,
+    const Size3& size,
+    Array3<double>* sampled) {
+    sampled->resize(size);
+
+    // Most callers pass either a grid-backed SDF or one of the constant
+    // default fields. Both get a concrete fast path: a grid-backed SDF is
+    // sampled through an inlinable LinearArraySampler3 over its data, and a
+    // constant field is a single sample plus a fill. Everything else falls
+    // back to the virtual sampler.
+    if (const ScalarGrid3* grid = dynamic_cast<const ScalarGrid3*>(&sdf)) {
+        LinearArraySampler3<double, double> gridSampler(
+            grid->constDataAccessor(), grid->gridSpacing(),
+            grid->dataOrigin());
+        presampleSdfImpl(
+            gridSampler, origin, gridSpacing, size, sampled->accessor());
+    } else if (dynamic_cast<const ConstantScalarField3*>(&sdf) != nullptr) {
+        sampled->set(sdf.sample(Vector3D()));
+    } else {
+        auto virtualSampler
+            = [&sdf](const Vector3D& pt) { return sdf.sample(pt); };
+        presampleSdfImpl(
+            virtualSampler, origin, gridSpacing, size, sampled->accessor());
     }
+}
 
-    if (k > 0 && marker(i, j, k - 1) == kFluid) {
-        dback = center - data(i, j, k - 1);
+// Classifies one row of data points against presampled boundary and fluid
+// SDF rows and packs the markers 32 cells per 64-bit word.
+static void classifyMarkerRow(
+    uint64_t* rowWords,
+    size_t sizeX,
+    const double* boundaryRow,
+    const double* fluidRow) {
+    uint64_t word = 0;
+    for (size_t i = 0; i < sizeX; ++i) {
+        char marker;
+        if (isInsideSdf(boundaryRow[i])) {
+            marker = kBoundary;
+        } else if (isInsideSdf(fluidRow[i])) {
+            marker = kFluid;
+        } else {
+            marker = kAir;
+        }
+        word |= static_cast<uint64_t>(marker) << ((i & 31) * 2);
+        if ((i & 31) == 31) {
+            rowWords[i >> 5] = word;
+            word = 0;
+        }
     }
-    if (k + 1 < ds.z && marker(i, j, k + 1) == kFluid) {
-        dfront = data(i, j, k + 1) - center;
+    if ((sizeX & 31) != 0) {
+        rowWords[(sizeX - 1) >> 5] = word;
     }
+}
+
+// Runs the masked forward Euler update over \p numChannels contiguous scalar
+// channels that share one marker classification. Each (j, k) tile first
+// classifies its own rows plus a one-row halo into a thread-local scratchpad
+// via \p classifyRow, then updates every channel's rows of the tile, so
+// classification, diffusion, and write-out stay within one cache-resident
+// region and no full-grid marker volume exists. Interior rows are free of
+// bounds checks and walk i contiguously with the neighbor tests folded into
+// arithmetic selects, so the hot stencil auto-vectorizes; the remaining
+// one-cell shell takes the checked path. RealT is double or, for the
+// single-precision path, float. A non-zero StaticSizeX bakes the row length
+// in as a compile-time constant, which fixes the trip count of the hot
+// i-loop so the vectorizer drops its runtime tail checks; zero keeps the
+// length dynamic.
+template <size_t StaticSizeX, typename RealT, typename ClassifyRow>
+static void diffuseChannelsImpl(
+    const ConstArrayAccessor3<RealT>* srcs,
+    ArrayAccessor3<RealT>* dsts,
+    size_t numChannels,
+    const ClassifyRow& classifyRow,
+    RealT c,
+    const Vector3D& invH2) {
+    const Size3 ds = srcs[0].size();
+    const size_t nx = (StaticSizeX != 0) ? StaticSizeX : ds.x;
+    const RealT invHx2 = static_cast<RealT>(invH2.x);
+    const RealT invHy2 = static_cast<RealT>(invH2.y);
+    const RealT invHz2 = static_cast<RealT>(invH2.z);
+
+    parallelForTiled3D(
+        kZeroSize, ds.y, kZeroSize, ds.z, kTileSizeJ, kTileSizeK,
+        [&](size_t jBegin, size_t jEnd, size_t kBegin, size_t kEnd) {
+            static thread_local TileMarkers markers;
+            markers.reset(ds, jBegin, jEnd, kBegin, kEnd);
+
+            const size_t jHi = std::min(jEnd + 1, ds.y);
+            const size_t kHi = std::min(kEnd + 1, ds.z);
+            for (size_t k = markers.kLo; k < kHi; ++k) {
+                for (size_t j = markers.jLo; j < jHi; ++j) {
+                    classifyRow(markers.row(j, k), j, k);
+                }
+            }
+
+            auto genericUpdate = [&](const ConstArrayAccessor3<RealT>& src,
+                                     ArrayAccessor3<RealT>& dst,
+                                     size_t i, size_t j, size_t k) {
+                if (markers(i, j, k) == kFluid) {
+                    dst(i, j, k)
+                        = src(i, j, k)
+                        + c * static_cast<RealT>(laplacianFluidMasked(
+                            src, markers, kFluid, invH2, i, j, k));
+                } else {
+                    dst(i, j, k) = src(i, j, k);
+                }
+            };
+
+            auto processRow = [&](const ConstArrayAccessor3<RealT>& src,
+                                  ArrayAccessor3<RealT>& dst,
+                                  size_t j, size_t k) {
+                if (j == 0 || j + 1 == ds.y || k == 0 || k + 1 == ds.z
+                    || nx < 3) {
+                    for (size_t i = 0; i < nx; ++i) {
+                        genericUpdate(src, dst, i, j, k);
+                    }
+                    return;
+                }
+
+                genericUpdate(src, dst, 0, j, k);
+                genericUpdate(src, dst, nx - 1, j, k);
+
+                const size_t row = src.index(0, j, k);
+                const RealT* s = src.data() + row;
+                const RealT* sjm = src.data() + src.index(0, j - 1, k);
+                const RealT* sjp = src.data() + src.index(0, j + 1, k);
+                const RealT* skm = src.data() + src.index(0, j, k - 1);
+                const RealT* skp = src.data() + src.index(0, j, k + 1);
+                const uint64_t* m = markers.row(j, k);
+                const uint64_t* mjm = markers.row(j - 1, k);
+                const uint64_t* mjp = markers.row(j + 1, k);
+                const uint64_t* mkm = markers.row(j, k - 1);
+                const uint64_t* mkp = markers.row(j, k + 1);
+                RealT* d = dst.data() + row;
+
+                // Extracts the 2-bit marker for cell i of a packed row and
+                // maps kFluid to weight 1, everything else to 0.
+                auto fluidWeight = [](const uint64_t* rowWords, size_t i) {
+                    return ((rowWords[i >> 5] >> ((i & 31) * 2)) & UINT64_C(3))
+                        == 0 ? RealT(1) : RealT(0);
+                };
+
+                for (size_t i = 1; i + 1 < nx; ++i) {
+                    const RealT center = s[i];
+
+                    const RealT wl = fluidWeight(m, i - 1);
+                    const RealT wr = fluidWeight(m, i + 1);
+                    const RealT wd = fluidWeight(mjm, i);
+                    const RealT wu = fluidWeight(mjp, i);
+                    const RealT wb = fluidWeight(mkm, i);
+                    const RealT wf = fluidWeight(mkp, i);
+
+                    const RealT dleft = wl * (center - s[i - 1]);
+                    const RealT dright = wr * (s[i + 1] - center);
+                    const RealT ddown = wd * (center - sjm[i]);
+                    const RealT dup = wu * (sjp[i] - center);
+                    const RealT dback = wb * (center - skm[i]);
+                    const RealT dfront = wf * (skp[i] - center);
+
+                    const RealT lap
+                        = (dright - dleft) * invHx2
+                        + (dup - ddown) * invHy2
+                        + (dfront - dback) * invHz2;
+
+                    d[i] = (fluidWeight(m, i) != RealT(0))
+                        ? center + c * lap : center;
+                }
+            };
+
+            for (size_t ch = 0; ch < numChannels; ++ch) {
+                const ConstArrayAccessor3<RealT>& src = srcs[ch];
+                ArrayAccessor3<RealT>& dst = dsts[ch];
+                for (size_t k = kBegin; k < kEnd; ++k) {
+                    for (size_t j = jBegin; j < jEnd; ++j) {
+                        processRow(src, dst, j, k);
+                    }
+                }
+            }
+        });
+}
 
-    return (dright - dleft) / square(gridSpacing.x)
-        + (dup - ddown) / square(gridSpacing.y)
-        + (dfront - dback) / square(gridSpacing.z);
+// Dispatches to a kernel instantiation with the row length baked in for the
+// common power-of-two resolutions, and to the dynamic-length kernel for
+// everything else. Simulations run at a fixed resolution for many frames,
+// so one of the specialized instantiations is usually hit every call. Only
+// the i-extent is specialized; the j/k extents just bound outer loops where
+// a compile-time constant buys nothing.
+template <typename RealT, typename ClassifyRow>
+static void diffuseChannels(
+    const ConstArrayAccessor3<RealT>* srcs,
+    ArrayAccessor3<RealT>* dsts,
+    size_t numChannels,
+    const ClassifyRow& classifyRow,
+    RealT c,
+    const Vector3D& invH2) {
+    switch (srcs[0].size().x) {
+        case 64:
+            diffuseChannelsImpl<64>(
+                srcs, dsts, numChannels, classifyRow, c, invH2);
+            break;
+        case 128:
+            diffuseChannelsImpl<128>(
+                srcs, dsts, numChannels, classifyRow, c, invH2);
+            break;
+        case 256:
+            diffuseChannelsImpl<256>(
+                srcs, dsts, numChannels, classifyRow, c, invH2);
+            break;
+        default:
+            diffuseChannelsImpl<0>(
+                srcs, dsts, numChannels, classifyRow, c, invH2);
+            break;
+    }
 }
 
 GridForwardEulerDiffusionSolver3::GridForwardEulerDiffusionSolver3() {
 }
 
+bool GridForwardEulerDiffusionSolver3::useSinglePrecision() const {
+    return _useSinglePrecision;
+}
+
+void GridForwardEulerDiffusionSolver3::setUseSinglePrecision(bool enabled) {
+    _useSinglePrecision = enabled;
+}
+
 void GridForwardEulerDiffusionSolver3::solve(
     const ScalarGrid3& source,
     double diffusionCoefficient,
@@ -71,23 +349,201 @@ void GridForwardEulerDiffusionSolver3::solve(
     ScalarGrid3* dest,
     const ScalarField3& boundarySdf,
     const ScalarField3& fluidSdf) {
+    const Vector3D h = source.gridSpacing();
+    const Size3 ds = source.dataSize();
+    const Vector3D origin = source.dataOrigin();
+
+    // The SDFs are sampled once onto the data-point lattice; the per-tile
+    // classification then reads plain rows, so tiles re-reading their halo
+    // rows cost array loads instead of repeated virtual samples.
+    Array3<double> boundarySampled, fluidSampled;
+    presampleSdf(boundarySdf, origin, h, ds, &boundarySampled);
+    presampleSdf(fluidSdf, origin, h, ds, &fluidSampled);
+    auto bSdf = boundarySampled.constAccessor();
+    auto fSdf = fluidSampled.constAccessor();
+    auto classifyRow = [&](uint64_t* rowWords, size_t j, size_t k) {
+        const size_t row = bSdf.index(0, j, k);
+        classifyMarkerRow(
+            rowWords, ds.x, bSdf.data() + row, fSdf.data() + row);
+    };
+
+    // Loop-invariant coefficients; the per-cell stencil is then three
+    // multiply-adds instead of three divisions.
+    const double c = diffusionCoefficient * timeIntervalInSeconds;
+    const Vector3D invH2(
+        1.0 / square(h.x), 1.0 / square(h.y), 1.0 / square(h.z));
+
+    if (_useSinglePrecision) {
+        // Stage the field through FP32; the conversion happens once per cell
+        // on load and store while the stencil itself runs on float rows.
+        auto src = source.constDataAccessor();
+        auto dst = dest->dataAccessor();
+        Array3<float> srcF(ds), dstF(ds);
+
+        parallelFor(
+            kZeroSize, ds.x, kZeroSize, ds.y, kZeroSize, ds.z,
+            [&](size_t i, size_t j, size_t k) {
+                srcF(i, j, k) = static_cast<float>(src(i, j, k));
+            });
+
+        ConstArrayAccessor3<float> srcs[1] = {srcF.constAccessor()};
+        ArrayAccessor3<float> dsts[1] = {dstF.accessor()};
+        diffuseChannels(
+            srcs, dsts, 1, classifyRow, static_cast<float>(c), invH2);
+
+        parallelFor(
+            kZeroSize, ds.x, kZeroSize, ds.y, kZeroSize, ds.z,
+            [&](size_t i, size_t j, size_t k) {
+                dst(i, j, k) = dstF(i, j, k);
+            });
+    } else {
+        ConstArrayAccessor3<double> srcs[1] = {source.constDataAccessor()};
+        ArrayAccessor3<double> dsts[1] = {dest->dataAccessor()};
+        diffuseChannels(srcs, dsts, 1, classifyRow, c, invH2);
+    }
+}
+
+// Advances numberOfSubTimeSteps forward Euler sub-steps over one scalar
+// channel through a pair of ping-pong scratch buffers. The channel is staged
+// into RealT once, stepped in place, and stored back once, so per-sub-step
+// traffic is just the two scratch arrays.
+template <typename RealT, typename ClassifyRow>
+static void diffuseScalarChannelMulti(
+    const ConstArrayAccessor3<double>& src,
+    ArrayAccessor3<double> dst,
+    const ClassifyRow& classifyRow,
+    unsigned int numberOfSubTimeSteps,
+    RealT c,
+    const Vector3D& invH2) {
+    const Size3 ds = src.size();
+
+    Array3<RealT> ping(ds), pong(ds);
+    parallelFor(
+        kZeroSize, ds.x, kZeroSize, ds.y, kZeroSize, ds.z,
+        [&](size_t i, size_t j, size_t k) {
+            ping(i, j, k) = static_cast<RealT>(src(i, j, k));
+        });
+
+    for (unsigned int t = 0; t < numberOfSubTimeSteps; ++t) {
+        ConstArrayAccessor3<RealT> srcs[1] = {ping.constAccessor()};
+        ArrayAccessor3<RealT> dsts[1] = {pong.accessor()};
+        diffuseChannels(srcs, dsts, 1, classifyRow, c, invH2);
+        ping.swap(pong);
+    }
+
+    parallelFor(
+        kZeroSize, ds.x, kZeroSize, ds.y, kZeroSize, ds.z,
+        [&](size_t i, size_t j, size_t k) {
+            dst(i, j, k) = ping(i, j, k);
+        });
+}
+
+void GridForwardEulerDiffusionSolver3::solveMulti(
+    const ScalarGrid3& source,
+    double diffusionCoefficient,
+    double timeIntervalInSeconds,
+    unsigned int numberOfSubTimeSteps,
+    ScalarGrid3* dest,
+    const ScalarField3& boundarySdf,
+    const ScalarField3& fluidSdf) {
+    const Vector3D h = source.gridSpacing();
+    const Size3 ds = source.dataSize();
+    const Vector3D origin = source.dataOrigin();
+
     auto src = source.constDataAccessor();
-    Vector3D h = source.gridSpacing();
-    auto pos = source.dataPosition();
+    auto dst = dest->dataAccessor();
+
+    if (numberOfSubTimeSteps == 0) {
+        parallelFor(
+            kZeroSize, ds.x, kZeroSize, ds.y, kZeroSize, ds.z,
+            [&](size_t i, size_t j, size_t k) {
+                dst(i, j, k) = src(i, j, k);
+            });
+        return;
+    }
 
-    buildMarkers(source.resolution(), pos, boundarySdf, fluidSdf);
+    // The SDFs do not change across sub-steps, so they are sampled once and
+    // the markers are classified once up front into a packed volume; each
+    // sub-step's tiles copy their rows out of it instead of re-classifying.
+    // The SDF sampling is the dominant cost of a single solve, so it is
+    // paid once rather than numberOfSubTimeSteps times.
+    TileMarkers markerVolume;
+    markerVolume.reset(ds, 0, ds.y, 0, ds.z);
+    {
+        Array3<double> boundarySampled, fluidSampled;
+        presampleSdf(boundarySdf, origin, h, ds, &boundarySampled);
+        presampleSdf(fluidSdf, origin, h, ds, &fluidSampled);
+        auto bSdf = boundarySampled.constAccessor();
+        auto fSdf = fluidSampled.constAccessor();
 
-    source.parallelForEachDataPointIndex(
+        parallelForTiled3D(
+            kZeroSize, ds.y, kZeroSize, ds.z, kTileSizeJ, kTileSizeK,
+            [&](size_t jBegin, size_t jEnd, size_t kBegin, size_t kEnd) {
+                for (size_t k = kBegin; k < kEnd; ++k) {
+                    for (size_t j = jBegin; j < jEnd; ++j) {
+                        const size_t row = bSdf.index(0, j, k);
+                        classifyMarkerRow(
+                            markerVolume.row(j, k), ds.x,
+                            bSdf.data() + row, fSdf.data() + row);
+                    }
+                }
+            });
+    }
+    auto classifyRow = [&](uint64_t* rowWords, size_t j, size_t k) {
+        const uint64_t* rowIn = markerVolume.row(j, k);
+        std::copy(rowIn, rowIn + markerVolume.wordsPerRow, rowWords);
+    };
+
+    const double subDt = timeIntervalInSeconds / numberOfSubTimeSteps;
+    const double c = diffusionCoefficient * subDt;
+    const Vector3D invH2(
+        1.0 / square(h.x), 1.0 / square(h.y), 1.0 / square(h.z));
+
+    if (_useSinglePrecision) {
+        diffuseScalarChannelMulti<float>(
+            src, dst, classifyRow, numberOfSubTimeSteps,
+            static_cast<float>(c), invH2);
+    } else {
+        diffuseScalarChannelMulti<double>(
+            src, dst, classifyRow, numberOfSubTimeSteps, c, invH2);
+    }
+}
+
+// Splits an AoS Vector3D field into three RealT channels, diffuses all three
+// through one shared-marker tile traversal, and scatters the results back.
+template <typename RealT, typename ClassifyRow>
+static void diffuseVectorChannels(
+    const ConstArrayAccessor3<Vector3D>& src,
+    CollocatedVectorGrid3* dest,
+    const ClassifyRow& classifyRow,
+    double c,
+    const Vector3D& invH2) {
+    const Size3 ds = src.size();
+
+    Array3<RealT> srcX(ds), srcY(ds), srcZ(ds);
+    Array3<RealT> dstX(ds), dstY(ds), dstZ(ds);
+
+    parallelFor(
+        kZeroSize, ds.x, kZeroSize, ds.y, kZeroSize, ds.z,
         [&](size_t i, size_t j, size_t k) {
-            if (_markers(i, j, k) == kFluid) {
-                (*dest)(i, j, k)
-                    = source(i, j, k)
-                    + diffusionCoefficient
-                    * timeIntervalInSeconds
-                    * laplacian(src, _markers, h, i, j, k);
-            } else {
-                (*dest)(i, j, k) = source(i, j, k);
-            }
+            const Vector3D& v = src(i, j, k);
+            srcX(i, j, k) = static_cast<RealT>(v.x);
+            srcY(i, j, k) = static_cast<RealT>(v.y);
+            srcZ(i, j, k) = static_cast<RealT>(v.z);
+        });
+
+    ConstArrayAccessor3<RealT> srcs[3] = {
+        srcX.constAccessor(), srcY.constAccessor(), srcZ.constAccessor()};
+    ArrayAccessor3<RealT> dsts[3] = {
+        dstX.accessor(), dstY.accessor(), dstZ.accessor()};
+    diffuseChannels(
+        srcs, dsts, 3, classifyRow, static_cast<RealT>(c), invH2);
+
+    parallelFor(
+        kZeroSize, ds.x, kZeroSize, ds.y, kZeroSize, ds.z,
+        [&](size_t i, size_t j, size_t k) {
+            (*dest)(i, j, k) = Vector3D(
+                dstX(i, j, k), dstY(i, j, k), dstZ(i, j, k));
         });
 }
 
@@ -99,23 +555,36 @@ void GridForwardEulerDiffusionSolver3::solve(
     const ScalarField3& boundarySdf,
     const ScalarField3& fluidSdf) {
     auto src = source.constDataAccessor();
-    Vector3D h = source.gridSpacing();
-    auto pos = source.dataPosition();
+    const Vector3D h = source.gridSpacing();
+    const Size3 ds = src.size();
+    const Vector3D origin = source.dataOrigin();
 
-    buildMarkers(source.resolution(), pos, boundarySdf, fluidSdf);
+    Array3<double> boundarySampled, fluidSampled;
+    presampleSdf(boundarySdf, origin, h, ds, &boundarySampled);
+    presampleSdf(fluidSdf, origin, h, ds, &fluidSampled);
+    auto bSdf = boundarySampled.constAccessor();
+    auto fSdf = fluidSampled.constAccessor();
+    auto classifyRow = [&](uint64_t* rowWords, size_t j, size_t k) {
+        const size_t row = bSdf.index(0, j, k);
+        classifyMarkerRow(
+            rowWords, ds.x, bSdf.data() + row, fSdf.data() + row);
+    };
 
-    source.parallelForEachDataPointIndex(
-        [&](size_t i, size_t j, size_t k) {
-            if (_markers(i, j, k) == kFluid) {
-                (*dest)(i, j, k)
-                    = src(i, j, k)
-                    + diffusionCoefficient
-                    * timeIntervalInSeconds
-                    * laplacian(src, _markers, h, i, j, k);
-            } else {
-                (*dest)(i, j, k) = source(i, j, k);
-            }
-        });
+    const double c = diffusionCoefficient * timeIntervalInSeconds;
+    const Vector3D invH2(
+        1.0 / square(h.x), 1.0 / square(h.y), 1.0 / square(h.z));
+
+    // The Vector3D data is AoS, which would make the stencil gather strided
+    // 24-byte elements. Split it into three scalar channels, push them
+    // through the contiguous vectorized kernel with one tile-local marker
+    // classification shared by all three, and scatter the results back. The
+    // channel staging doubles as the FP32 conversion point when single
+    // precision is enabled.
+    if (_useSinglePrecision) {
+        diffuseVectorChannels<float>(src, dest, classifyRow, c, invH2);
+    } else {
+        diffuseVectorChannels<double>(src, dest, classifyRow, c, invH2);
+    }
 }
 
 void GridForwardEulerDiffusionSolver3::solve(
@@ -125,72 +594,86 @@ void GridForwardEulerDiffusionSolver3::solve(
     FaceCenteredGrid3* dest,
     const ScalarField3& boundarySdf,
     const ScalarField3& fluidSdf) {
+    UNUSED_VARIABLE(fluidSdf);
+
     auto uSrc = source.uConstAccessor();
     auto vSrc = source.vConstAccessor();
     auto wSrc = source.wConstAccessor();
     auto u = dest->uAccessor();
     auto v = dest->vAccessor();
     auto w = dest->wAccessor();
-    auto uPos = source.uPosition();
-    auto vPos = source.vPosition();
-    auto wPos = source.wPosition();
     Vector3D h = source.gridSpacing();
+    const double c = diffusionCoefficient * timeIntervalInSeconds;
+    const Size3 uSize = source.uSize();
+    const Size3 vSize = source.vSize();
+    const Size3 wSize = source.wSize();
+    const Vector3D uOrigin = source.uOrigin();
+    const Vector3D vOrigin = source.vOrigin();
+    const Vector3D wOrigin = source.wOrigin();
 
-    buildMarkers(source.uSize(), uPos, boundarySdf, fluidSdf);
+    // The boundary SDF is sampled once per staggered lattice up front; the
+    // three lattices are disjoint point sets, so this is the minimum number
+    // of virtual samples, and the update tiles below read plain rows.
+    Array3<double> uSdf, vSdf, wSdf;
+    presampleSdf(boundarySdf, uOrigin, h, uSize, &uSdf);
+    presampleSdf(boundarySdf, vOrigin, h, vSize, &vSdf);
+    presampleSdf(boundarySdf, wOrigin, h, wSize, &wSdf);
 
-    source.parallelForEachUIndex(
-        [&](size_t i, size_t j, size_t k) {
-            if (!isInsideSdf(boundarySdf.sample(uPos(i, j, k)))) {
-                u(i, j, k)
-                    = uSrc(i, j, k)
-                    + diffusionCoefficient
-                    * timeIntervalInSeconds
-                    * laplacian3(uSrc, h, i, j, k);
-            }
-        });
+    // Updates one row of a staggered component. The boundary classification
+    // is hoisted out of the stencil loop into a stack-resident bitmask per
+    // row chunk read from the presampled SDF, so the update loop carries no
+    // virtual sampler call.
+    auto updateRow = [&](const ConstArrayAccessor3<double>& compSrc,
+                         ArrayAccessor3<double> compDst,
+                         const ConstArrayAccessor3<double>& compSdf,
+                         size_t j, size_t k) {
+        const size_t nx = compSrc.size().x;
+        const double* sdfRow = compSdf.data() + compSdf.index(0, j, k);
 
-    buildMarkers(source.vSize(), vPos, boundarySdf, fluidSdf);
+        for (size_t iBegin = 0; iBegin < nx; iBegin += kRowChunkSize) {
+            const size_t iEnd = std::min(iBegin + kRowChunkSize, nx);
 
-    source.parallelForEachVIndex(
-        [&](size_t i, size_t j, size_t k) {
-            if (!isInsideSdf(boundarySdf.sample(vPos(i, j, k)))) {
-                v(i, j, k)
-                    = vSrc(i, j, k)
-                    + diffusionCoefficient
-                    * timeIntervalInSeconds
-                    * laplacian3(vSrc, h, i, j, k);
+            uint64_t mask[kRowChunkSize / 64] = {0};
+            for (size_t i = iBegin; i < iEnd; ++i) {
+                if (!isInsideSdf(sdfRow[i])) {
+                    mask[(i - iBegin) >> 6]
+                        |= UINT64_C(1) << ((i - iBegin) & 63);
+                }
             }
-        });
-
-    buildMarkers(source.wSize(), wPos, boundarySdf, fluidSdf);
 
-    source.parallelForEachUIndex(
-        [&](size_t i, size_t j, size_t k) {
-            if (!isInsideSdf(boundarySdf.sample(wPos(i, j, k)))) {
-                w(i, j, k)
-                    = wSrc(i, j, k)
-                    + diffusionCoefficient
-                    * timeIntervalInSeconds
-                    * laplacian3(wSrc, h, i, j, k);
+            for (size_t i = iBegin; i < iEnd; ++i) {
+                if ((mask[(i - iBegin) >> 6] >> ((i - iBegin) & 63)) & 1) {
+                    compDst(i, j, k)
+                        = compSrc(i, j, k)
+                        + c * laplacian3(compSrc, h, i, j, k);
+                }
             }
-        });
-}
+        }
+    };
 
-void GridForwardEulerDiffusionSolver3::buildMarkers(
-    const Size3& size,
-    const std::function<Vector3D(size_t, size_t, size_t)>& pos,
-    const ScalarField3& boundarySdf,
-    const ScalarField3& fluidSdf) {
-    _markers.resize(size);
+    // One fused tile traversal updates all three components, so the
+    // boundary SDF and the velocity data of a (j, k) neighborhood are
+    // touched once instead of in three cold full-grid passes. The
+    // per-component marker builds that used to precede each pass are gone
+    // entirely; their output was never read by this path.
+    const size_t jMax = std::max(uSize.y, std::max(vSize.y, wSize.y));
+    const size_t kMax = std::max(uSize.z, std::max(vSize.z, wSize.z));
 
-    _markers.forEachIndex(
-        [&](size_t i, size_t j, size_t k) {
-            if (isInsideSdf(boundarySdf.sample(pos(i, j, k)))) {
-                _markers(i, j, k) = kBoundary;
-            } else if (isInsideSdf(fluidSdf.sample(pos(i, j, k)))) {
-                _markers(i, j, k) = kFluid;
-            } else {
-                _markers(i, j, k) = kAir;
+    parallelForTiled3D(
+        kZeroSize, jMax, kZeroSize, kMax, kTileSizeJ, kTileSizeK,
+        [&](size_t jBegin, size_t jEnd, size_t kBegin, size_t kEnd) {
+            for (size_t k = kBegin; k < kEnd; ++k) {
+                for (size_t j = jBegin; j < jEnd; ++j) {
+                    if (j < uSize.y && k < uSize.z) {
+                        updateRow(uSrc, u, uSdf.constAccessor(), j, k);
+                    }
+                    if (j < vSize.y && k < vSize.z) {
+                        updateRow(vSrc, v, vSdf.constAccessor(), j, k);
+                    }
+                    if (j < wSize.y && k < wSize.z) {
+                        updateRow(wSrc, w, wSdf.constAccessor(), j, k);
+                    }
+                }
             }
         });
 }
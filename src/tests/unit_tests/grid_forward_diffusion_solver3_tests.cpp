@@ -27,3 +27,29 @@ TEST(GridForwardEulerDiffusionSolver3, Solve) {
     EXPECT_DOUBLE_EQ(1.0/12.0, dst(1, 1, 2));
     EXPECT_DOUBLE_EQ(1.0/2.0,  dst(1, 1, 1));
 }
+
+TEST(GridForwardEulerDiffusionSolver3, SolveMulti) {
+    CellCenteredScalarGrid3 src(3, 3, 3, 1.0, 1.0, 1.0, 0.0, 0.0, 0.0);
+    CellCenteredScalarGrid3 dst(3, 3, 3, 1.0, 1.0, 1.0, 0.0, 0.0, 0.0);
+    CellCenteredScalarGrid3 mid(3, 3, 3, 1.0, 1.0, 1.0, 0.0, 0.0, 0.0);
+    CellCenteredScalarGrid3 expected(3, 3, 3, 1.0, 1.0, 1.0, 0.0, 0.0, 0.0);
+
+    src(1, 1, 1) = 1.0;
+
+    GridForwardEulerDiffusionSolver3 diffusionSolver;
+    diffusionSolver.solveMulti(src, 1.0 / 12.0, 1.0, 2, &dst);
+
+    // Two sub-steps must match two individual solves of half the interval.
+    diffusionSolver.solve(src, 1.0 / 12.0, 0.5, &mid);
+    diffusionSolver.solve(mid, 1.0 / 12.0, 0.5, &expected);
+
+    expected.forEachDataPointIndex([&](size_t i, size_t j, size_t k) {
+        EXPECT_DOUBLE_EQ(expected(i, j, k), dst(i, j, k));
+    });
+
+    // Zero sub-steps copies the input unchanged.
+    diffusionSolver.solveMulti(src, 1.0 / 12.0, 1.0, 0, &dst);
+    src.forEachDataPointIndex([&](size_t i, size_t j, size_t k) {
+        EXPECT_DOUBLE_EQ(src(i, j, k), dst(i, j, k));
+    });
+}